@@ -2,18 +2,83 @@
 
 #include <chrono>
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <new>
 #include <thread>
 #include <vector>
 
 #include "wave.h"
 #include "sand.h"
 #include "scene.h"
+#include "profiler.h"
 #include "utils.h"
 
 
-int main()
+// Count heap allocations for the profiler
+void* operator new(std::size_t size) {
+    allocationCounter()++;
+    if (void *p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+
+int runHeadless(int frames) {
+    // Runs the Chladni scene with a fixed timestep and no window, then reports profiler counters
+    // and writes profile_trace.json / profile.csv to the working directory
+    const double dt = 1.0 / 60;
+    sf::Vector2f plateInputPos(-250, 250);
+    sf::Vector2f plateInputSize(500, 500);
+    Wave WavePlate(10);
+    Sand SandPlate(WavePlate, plateInputPos, plateInputPos);
+    Profiler profiler;
+
+    Scene chladni = createScene(0);
+    WavePlate.boundaryVertices2f = chladni.boundary;
+    WavePlate.wavePoints = chladni.waveSources;
+    WavePlate.begin(dt);
+    SandPlate.begin();
+
+    for (int y = 5; y < WavePlate.height - 5; y += 2) {
+        for (int x = 5; x < WavePlate.width - 5; x += 2) {
+            SandPlate.addParticle(Particle(sf::Vector2f(x, y), sf::Vector2f(0, 0), sf::Color::Yellow, 0.5f));
+        }
+    }
+
+    double elapsed_t = 0.0;
+    for (int frame = 0; frame < frames; frame++) {
+        profiler.beginFrame();
+        elapsed_t += dt;
+        {
+            ScopedTimer timer(profiler, PHASE_WAVE_UPDATE);
+            WavePlate.update(dt, elapsed_t);
+        }
+        {
+            ScopedTimer timer(profiler, PHASE_SAND_UPDATE);
+            SandPlate.update(dt);
+        }
+        profiler.addCells(static_cast<long>(WavePlate.width) * WavePlate.height);
+        profiler.addParticles(SandPlate.particles.size());
+        profiler.endFrame();
+    }
+
+    profiler.printReport();
+    profiler.exportChromeTrace("profile_trace.json");
+    profiler.exportCSV("profile.csv");
+    return 0;
+}
+
+
+int main(int argc, char **argv)
 {
+    // Usage: ./app --headless [frames]
+    if (argc > 1 && std::strcmp(argv[1], "--headless") == 0) {
+        return runHeadless(argc > 2 ? std::atoi(argv[2]) : 600);
+    }
+
     printf("Start\n");
 
     // WINDOW CONFIGURATIONS
@@ -29,12 +94,18 @@ int main()
     sf::View view(sf::Vector2f(0, 0), sf::Vector2f(V_WIDTH, -V_HEIGHT));
     window.setView(view);
 
+    // VIEWPORT (wheel: zoom, middle drag: pan, Home: reset view and input boxes)
+    const float initialUnitsPerPixel = static_cast<float>(V_WIDTH) / W_WIDTH;
+    float unitsPerPixel = initialUnitsPerPixel;
+    bool panning = false;
+    sf::Vector2i panAnchor;
+
     // PLATE INPUT VIEWBOX
     bool viewPlate = true;
     double c = 10, waveFrequency = 0.2;
     sf::Vector2f plateInputPos(-250, 250);
     sf::Vector2f plateInputSize(500, 500);
-    Wave WavePlate(c, plateInputPos, plateInputSize);
+    Wave WavePlate(c);
     
     // SAND VIEWBOX
     double r = 0.2;
@@ -43,6 +114,17 @@ int main()
     sf::Vector2f sandViewSize(500, 500);
     Sand SandPlate(WavePlate, sandViewPos, plateInputPos);
 
+    // The input boxes stay fixed in world space around the origin; zooming out past the initial view
+    // scales them up with the zoom so plates larger than the window can be drawn. Home restores them.
+    const sf::Vector2f initialInputPos = plateInputPos, initialInputSize = plateInputSize;
+    auto fitInputToZoom = [&]() {
+        float scale = std::max(1.0f, unitsPerPixel / initialUnitsPerPixel);
+        plateInputPos = initialInputPos * scale;
+        plateInputSize = initialInputSize * scale;
+        sandViewPos = plateInputPos;
+        sandViewSize = plateInputSize;
+    };
+
     // EVENT LOOP VARIABLES
     double dt, elapsed_t = 0.0;
     double lastPlacedWaveSource = 0.0;
@@ -50,6 +132,9 @@ int main()
 
     bool leftMouseDown = false, rightMouseDown = false;
     sf::Vector2f mousePosition;
+
+    // PROFILER (P: toggle overlay, E: export trace & csv)
+    Profiler profiler;
     
     // MAIN EVENT LOOP
     while (window.isOpen())
@@ -59,18 +144,67 @@ int main()
         last_t = std::chrono::steady_clock::now();
         elapsed_t += dt;
 
+        profiler.beginFrame();
+
         // WINDOW EVENTS
+        Profiler::clock::time_point eventsStart = Profiler::clock::now();
         sf::Event event;
         while (window.pollEvent(event))
         {
             if (event.type == sf::Event::Closed) window.close();
 
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::P) {
+                profiler.showOverlay = !profiler.showOverlay;
+                if (profiler.showOverlay) profiler.printLegend();
+            }
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::E) {
+                profiler.exportChromeTrace("profile_trace.json");
+                profiler.exportCSV("profile.csv");
+                printf("Exported profile_trace.json, profile.csv\n");
+            }
+
+            if (event.type == sf::Event::MouseWheelScrolled) {
+                // Zoom about the cursor so the point under it stays put
+                float factor = (event.mouseWheelScroll.delta > 0) ? 0.8f : 1.25f;
+                sf::Vector2f anchor = window.mapPixelToCoords(sf::Vector2i(event.mouseWheelScroll.x, event.mouseWheelScroll.y));
+                view.setCenter(anchor + (view.getCenter() - anchor) * factor);
+                view.setSize(view.getSize() * factor);
+                unitsPerPixel *= factor;
+                window.setView(view);
+                fitInputToZoom();
+            }
+            if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Middle) {
+                panning = true;
+                panAnchor = sf::Vector2i(event.mouseButton.x, event.mouseButton.y);
+            }
+            if (event.type == sf::Event::MouseButtonReleased && event.mouseButton.button == sf::Mouse::Middle) panning = false;
+            if (event.type == sf::Event::MouseMoved && panning) {
+                sf::Vector2i pixel(event.mouseMove.x, event.mouseMove.y);
+                view.move(window.mapPixelToCoords(panAnchor) - window.mapPixelToCoords(pixel));
+                window.setView(view);
+                panAnchor = pixel;
+            }
+            if (event.type == sf::Event::Resized) {
+                // Keep the zoom level and show more or less of the world instead of stretching
+                view.setSize(event.size.width * unitsPerPixel, -(event.size.height * unitsPerPixel));
+                window.setView(view);
+            }
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Home) {
+                sf::Vector2u windowSize = window.getSize();
+                unitsPerPixel = initialUnitsPerPixel;
+                view.setCenter(0, 0);
+                view.setSize(windowSize.x * unitsPerPixel, -(windowSize.y * unitsPerPixel));
+                window.setView(view);
+                fitInputToZoom();
+            }
+
             mousePosition = window.mapPixelToCoords(sf::Mouse::getPosition(window));
             if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Right) viewPlate = !viewPlate;
 
             if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Left)
             {
                 leftMouseDown = true;
+
                 if (!WavePlate.boundaryVertices2f.empty()) {
                     WavePlate.boundaryVertices2f.clear();
                 }
@@ -119,23 +253,50 @@ int main()
                 }
             }
 
-             if (sf::Keyboard::isKeyPressed(sf::Keyboard::Num0)) {
-                Scene chladni = createScene(0);
-                WavePlate.boundaryVertices2f = chladni.boundary;
-                WavePlate.wavePoints = chladni.waveSources;
+             int sceneKey = -1;
+             if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Num0) sceneKey = 0;
+             if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Num1) sceneKey = 1;
+             if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Num2) sceneKey = 2;
+             if (sceneKey >= 0) {
+                // Scenes differ in size, so clear the old grid before loading
+                Scene scene = createScene(sceneKey);
+                WavePlate.reset();
+                SandPlate.reset();
+                WavePlate.boundaryVertices2f = scene.boundary;
+                WavePlate.wavePoints = scene.waveSources;
+                WavePlate.edgeMode = scene.edgeMode;
                 WavePlate.begin(dt);
                 SandPlate.begin();
              }
+
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::A) {
+                // Cycle edge condition: reflective -> absorbing boundary -> absorbing bounding box
+                WavePlate.setEdgeMode(static_cast<EdgeMode>((WavePlate.edgeMode + 1) % 3));
+            }
         }
+        profiler.record(PHASE_EVENTS, eventsStart, Profiler::clock::now());
 
         window.clear();
         
-        if (viewPlate) WavePlate.draw(window);
-        WavePlate.update(dt, elapsed_t);
-
+        if (viewPlate) {
+            ScopedTimer timer(profiler, PHASE_WAVE_DRAW);
+            WavePlate.draw(window);
+        }
+        {
+            ScopedTimer timer(profiler, PHASE_WAVE_UPDATE);
+            WavePlate.update(dt, elapsed_t);
+        }
+        if (WavePlate.simulating) profiler.addCells(static_cast<long>(WavePlate.width) * WavePlate.height);
 
-        SandPlate.update(dt);
-        SandPlate.draw(window);
+        {
+            ScopedTimer timer(profiler, PHASE_SAND_UPDATE);
+            SandPlate.update(dt);
+        }
+        if (WavePlate.simulating) profiler.addParticles(SandPlate.particles.size());
+        {
+            ScopedTimer timer(profiler, PHASE_SAND_DRAW);
+            SandPlate.draw(window);
+        }
 
         drawBoundary(window, WavePlate.boundaryVertices2f);
         drawBoundary(window, WavePlate.boundaryVertices2f, sandViewPos - plateInputPos);
@@ -144,8 +305,13 @@ int main()
         drawSquareOutline(window, sandViewPos  , sandViewSize  , sf::Color::White);
 
         drawCircle(window, mousePosition, 2.0f, sf::Color::Red);
+
+        profiler.drawOverlay(window);
         
         window.display();
+
+        profiler.endFrame();
+        if (profiler.frameCount % 30 == 0) window.setTitle("WavPro2D | " + profiler.summary());
     }
 
     return 0;
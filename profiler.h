@@ -0,0 +1,305 @@
+/*
+Frame profiler: scoped phase timers, rolling percentiles, on-screen overlay and trace export
+*/
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+
+enum Phase {
+    PHASE_EVENTS,
+    PHASE_WAVE_UPDATE,
+    PHASE_SAND_UPDATE,
+    PHASE_WAVE_DRAW,
+    PHASE_SAND_DRAW,
+    PHASE_FRAME,
+    PHASE_COUNT
+};
+
+inline const char* phaseName(int phase) {
+    static const char* names[PHASE_COUNT] = {
+        "Events", "Wave::update", "Sand::update", "Wave::draw", "Sand::draw", "Frame"
+    };
+    return names[phase];
+}
+
+inline sf::Color phaseColor(int phase) {
+    static const sf::Color colors[PHASE_COUNT] = {
+        sf::Color(200, 200, 200), sf::Color(80, 160, 255), sf::Color(255, 210, 60),   // Keep in sync with printLegend() and the README
+        sf::Color(80, 220, 120), sf::Color(255, 140, 60), sf::Color(255, 80, 80)
+    };
+    return colors[phase];
+}
+
+
+// Incremented by the global operator new replacement in main.cpp
+inline std::atomic<long>& allocationCounter() {
+    static std::atomic<long> count(0);
+    return count;
+}
+
+
+struct FrameStats {
+    double ms[PHASE_COUNT] = {};
+    long cells = 0, particles = 0, allocations = 0;
+};
+
+struct TraceEvent {
+    int phase;
+    double startUs, durationUs;
+};
+
+
+// Fixed-capacity buffer that overwrites its oldest entry; storage is allocated once up front
+template <typename T>
+class RingBuffer {
+
+public:
+    std::vector<T> items;
+    size_t head = 0, count = 0;
+
+    RingBuffer(size_t capacity) : items(capacity) {}
+
+    void push(const T &item) {
+        items[(head + count) % items.size()] = item;
+        if (count < items.size()) count++;
+        else head = (head + 1) % items.size();
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    // Oldest first
+    const T& operator[](size_t i) const { return items[(head + i) % items.size()]; }
+};
+
+
+class Profiler {
+
+public:
+    static const int HISTORY = 240;          // Frames kept for rolling percentiles
+    static const int MAX_RECORDED = 36000;   // Frames kept for export (10 minutes at 60 fps), oldest dropped first
+
+    typedef std::chrono::steady_clock clock;
+
+    bool showOverlay = false;
+
+    clock::time_point origin, frameStart;
+    FrameStats current;
+    long allocationsAtFrameStart = 0;
+
+    // Time and allocations spent drawing the overlay, excluded from the frame being measured
+    double overheadUs = 0;
+    long overheadAllocations = 0;
+
+    RingBuffer<FrameStats> history;
+    RingBuffer<FrameStats> recorded;
+    RingBuffer<TraceEvent> trace;
+    std::vector<double> samples;  // Scratch for percentile()
+    long frameCount = 0;
+
+    Profiler()
+        : origin(clock::now())
+        , history(HISTORY)
+        , recorded(MAX_RECORDED)
+        , trace(static_cast<size_t>(MAX_RECORDED) * PHASE_COUNT)
+        , samples(HISTORY)
+    {}
+
+    void beginFrame() {
+        current = FrameStats();
+        overheadUs = 0;
+        overheadAllocations = 0;
+        allocationsAtFrameStart = allocationCounter().load();
+        frameStart = clock::now();
+    }
+
+    void endFrame() {
+        clock::time_point frameEnd = clock::now() - std::chrono::duration_cast<clock::duration>(std::chrono::duration<double, std::micro>(overheadUs));
+        record(PHASE_FRAME, frameStart, frameEnd);
+        current.allocations = allocationCounter().load() - allocationsAtFrameStart - overheadAllocations;
+
+        history.push(current);
+        recorded.push(current);
+        frameCount++;
+    }
+
+    void record(int phase, clock::time_point start, clock::time_point end) {
+        double durationUs = std::chrono::duration<double, std::micro>(end - start).count();
+        double startUs = std::chrono::duration<double, std::micro>(start - origin).count();
+        current.ms[phase] += durationUs / 1000.0;
+        trace.push({phase, startUs, durationUs});
+    }
+
+    void addCells(long n)     { current.cells += n; }
+    void addParticles(long n) { current.particles += n; }
+
+
+    double percentile(int phase, double p) {
+        if (history.empty()) return 0;
+        size_t n = history.size();
+        for (size_t i = 0; i < n; i++) samples[i] = history[i].ms[phase];
+
+        size_t k = static_cast<size_t>(p * (n - 1));
+        std::nth_element(samples.begin(), samples.begin() + k, samples.begin() + n);
+        return samples[k];
+    }
+
+    // Throughput over the rolling window: work done / time spent in the phase doing it
+    double cellsPerSecond()     { return throughput(PHASE_WAVE_UPDATE, true); }
+    double particlesPerSecond() { return throughput(PHASE_SAND_UPDATE, false); }
+
+    double allocationsPerFrame() {
+        if (history.empty()) return 0;
+        double total = 0;
+        for (size_t i = 0; i < history.size(); i++) total += history[i].allocations;
+        return total / history.size();
+    }
+
+
+    std::string summary() {
+        char buffer[256];
+        snprintf(buffer, sizeof(buffer),
+            "frame p50 %.2fms p95 %.2fms | %.1f Mcells/s | %.1f Mparticles/s | %.1f allocs/frame",
+            percentile(PHASE_FRAME, 0.5), percentile(PHASE_FRAME, 0.95),
+            cellsPerSecond() / 1e6, particlesPerSecond() / 1e6, allocationsPerFrame());
+        return buffer;
+    }
+
+    void printLegend() {
+        // The overlay has no font, so its rows are named on the console instead
+        static const char* colorNames[PHASE_COUNT] = { "light grey", "blue", "yellow", "green", "orange", "red" };
+        printf("Profiler overlay rows (top to bottom), solid = p50, faded = p95, white tick = 60fps:\n");
+        for (int phase = 0; phase < PHASE_COUNT; phase++) {
+            printf("  %d. %-14s %s\n", phase + 1, phaseName(phase), colorNames[phase]);
+        }
+    }
+
+    void printReport() {
+        printf("%-14s %9s %9s %9s\n", "phase", "p50 ms", "p95 ms", "p99 ms");
+        for (int phase = 0; phase < PHASE_COUNT; phase++) {
+            printf("%-14s %9.3f %9.3f %9.3f\n", phaseName(phase),
+                percentile(phase, 0.5), percentile(phase, 0.95), percentile(phase, 0.99));
+        }
+        printf("%s\n", summary().c_str());
+    }
+
+
+    bool exportChromeTrace(const std::string &path) {
+        // Load in chrome://tracing or https://ui.perfetto.dev
+        FILE *file = fopen(path.c_str(), "w");
+        if (!file) return false;
+
+        fprintf(file, "{\"traceEvents\":[\n");
+        for (size_t i = 0; i < trace.size(); i++) {
+            fprintf(file, "{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1}%s\n",
+                phaseName(trace[i].phase), trace[i].startUs, trace[i].durationUs,
+                (i + 1 < trace.size()) ? "," : "");
+        }
+        fprintf(file, "],\"displayTimeUnit\":\"ms\"}\n");
+        fclose(file);
+        return true;
+    }
+
+    bool exportCSV(const std::string &path) {
+        FILE *file = fopen(path.c_str(), "w");
+        if (!file) return false;
+
+        fprintf(file, "frame");
+        for (int phase = 0; phase < PHASE_COUNT; phase++) fprintf(file, ",%s_ms", phaseName(phase));
+        fprintf(file, ",cells,particles,allocations\n");
+
+        long firstFrame = frameCount - static_cast<long>(recorded.size());
+        for (size_t i = 0; i < recorded.size(); i++) {
+            fprintf(file, "%ld", firstFrame + static_cast<long>(i));
+            for (int phase = 0; phase < PHASE_COUNT; phase++) fprintf(file, ",%.4f", recorded[i].ms[phase]);
+            fprintf(file, ",%ld,%ld,%ld\n", recorded[i].cells, recorded[i].particles, recorded[i].allocations);
+        }
+        fclose(file);
+        return true;
+    }
+
+
+    void drawOverlay(sf::RenderWindow &window) {
+        // Horizontal bars per phase in screen pixels: solid = p50, faded = p95, white tick = 60fps budget
+        if (!showOverlay || history.empty()) return;
+
+        clock::time_point overlayStart = clock::now();
+        long allocationsBefore = allocationCounter().load();
+
+        const float pixelsPerMs = 20, barHeight = 12, margin = 10;
+        sf::View worldView = window.getView();
+        window.setView(window.getDefaultView());
+
+        sf::RectangleShape background(sf::Vector2f(margin + 40 * pixelsPerMs, PHASE_COUNT * (barHeight + 4) + margin));
+        background.setPosition(0, 0);
+        background.setFillColor(sf::Color(0, 0, 0, 160));
+        window.draw(background);
+
+        for (int phase = 0; phase < PHASE_COUNT; phase++) {
+            float y = margin + phase * (barHeight + 4);
+            sf::Color color = phaseColor(phase);
+
+            sf::RectangleShape p95(sf::Vector2f(percentile(phase, 0.95) * pixelsPerMs, barHeight));
+            p95.setPosition(margin, y);
+            p95.setFillColor(sf::Color(color.r, color.g, color.b, 90));
+            window.draw(p95);
+
+            sf::RectangleShape p50(sf::Vector2f(percentile(phase, 0.5) * pixelsPerMs, barHeight));
+            p50.setPosition(margin, y);
+            p50.setFillColor(color);
+            window.draw(p50);
+        }
+
+        sf::RectangleShape budget(sf::Vector2f(1, PHASE_COUNT * (barHeight + 4)));
+        budget.setPosition(margin + 1000.0f / 60 * pixelsPerMs, margin);
+        budget.setFillColor(sf::Color::White);
+        window.draw(budget);
+
+        window.setView(worldView);
+
+        overheadUs += std::chrono::duration<double, std::micro>(clock::now() - overlayStart).count();
+        overheadAllocations += allocationCounter().load() - allocationsBefore;
+    }
+
+
+private:
+    double throughput(int phase, bool cells) {
+        double work = 0, seconds = 0;
+        for (size_t i = 0; i < history.size(); i++) {
+            work += cells ? history[i].cells : history[i].particles;
+            seconds += history[i].ms[phase] / 1000.0;
+        }
+        return (seconds > 0) ? work / seconds : 0;
+    }
+};
+
+
+class ScopedTimer {
+
+public:
+    Profiler &profiler;
+    int phase;
+    Profiler::clock::time_point start;
+
+    ScopedTimer(Profiler &profiler, int phase)
+        : profiler(profiler)
+        , phase(phase)
+        , start(Profiler::clock::now())
+    {}
+
+    ~ScopedTimer() {
+        profiler.record(phase, start, Profiler::clock::now());
+    }
+};
+
+
+#endif
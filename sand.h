@@ -6,7 +6,9 @@ Sand plate & sand particles
 #define SAND_H
 
 #include <SFML/Graphics.hpp>
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <random>
 #include <vector>
 
@@ -47,6 +49,16 @@ public:
     Wave *WavePlate;
     sf::Vector2f displayPosition, platePos, offset;
 
+    // Spatial hash for grain-grain collisions, rebuilt every step by counting sort
+    float cellSize = 1.0f;
+    int gridWidth = 0, gridHeight = 0;
+    std::vector<int> cellStart;      // cellStart[c] .. cellStart[c+1] indexes into cellParticles
+    std::vector<int> cellParticles;  // particle indices sorted by cell
+    std::vector<int> particleCell;   // cell of each particle
+    std::vector<int> cellFill;       // scatter cursor per cell
+    std::vector<sf::Vector2f> collisionShift;
+    int collisionIterations = 4;
+
     Sand(Wave &Plate, sf::Vector2f displayPosition, sf::Vector2f platePos)
         : WavePlate(&Plate) 
         , displayPosition(displayPosition)
@@ -95,6 +107,114 @@ public:
 
             particle.update(dt, estimated_accel);
         }
+
+        resolveCollisions();
+    }
+
+    int cellOf(const sf::Vector2f &position) {
+        int cx = static_cast<int>(clampf(position.x / cellSize, 0, gridWidth  - 1));
+        int cy = static_cast<int>(clampf(position.y / cellSize, 0, gridHeight - 1));
+        return cy * gridWidth + cx;
+    }
+
+    void buildSpatialHash() {
+        // Cells are one grain diameter wide so overlapping grains are always in adjacent cells
+        float maxRadius = 0;
+        for (auto &particle : particles) maxRadius = std::max(maxRadius, particle.radius);
+        cellSize = std::max(2 * maxRadius, 1.0f);
+
+        gridWidth  = std::max(1, static_cast<int>(std::ceil(WavePlate->width  / cellSize)));
+        gridHeight = std::max(1, static_cast<int>(std::ceil(WavePlate->height / cellSize)));
+        int cellCount = gridWidth * gridHeight;
+
+        // Counting sort: histogram, exclusive prefix sum, scatter
+        cellStart.assign(cellCount + 1, 0);
+        particleCell.resize(particles.size());
+        for (size_t i = 0; i < particles.size(); i++) {
+            particleCell[i] = cellOf(particles[i].position);
+            cellStart[particleCell[i] + 1]++;
+        }
+        for (int c = 0; c < cellCount; c++) cellStart[c + 1] += cellStart[c];
+
+        cellParticles.resize(particles.size());
+        cellFill.assign(cellStart.begin(), cellStart.end() - 1);
+        for (size_t i = 0; i < particles.size(); i++) {
+            cellParticles[cellFill[particleCell[i]]++] = static_cast<int>(i);
+        }
+    }
+
+    sf::Vector2f coincidentDirection(size_t i, size_t j) {
+        // Grains on the same point split along a pseudo-random angle per pair, antisymmetric in (i, j)
+        uint32_t h = static_cast<uint32_t>(std::min(i, j)) * 73856093u ^ static_cast<uint32_t>(std::max(i, j)) * 19349663u;
+        h ^= h >> 13; h *= 0x5bd1e995u; h ^= h >> 15;
+        float angle = static_cast<float>(h * (2 * M_PI / 4294967296.0));
+        float sign = (i < j) ? 1.0f : -1.0f;
+        return sf::Vector2f(sign * std::cos(angle), sign * std::sin(angle));
+    }
+
+    void resolveCollisions() {
+        if (particles.size() < 2) return;
+
+        for (int iteration = 0; iteration < collisionIterations; iteration++) {
+            buildSpatialHash();
+            if (!relaxCollisions()) break;
+        }
+    }
+
+    bool relaxCollisions() {
+        // One Jacobi pass: each grain only accumulates its own push so the loop over i has no write conflicts.
+        // Returns whether any grains overlapped.
+        collisionShift.assign(particles.size(), sf::Vector2f(0, 0));
+        bool overlapping = false;
+
+        for (size_t i = 0; i < particles.size(); i++) {
+            Particle &a = particles[i];
+            int cx = particleCell[i] % gridWidth;
+            int cy = particleCell[i] / gridWidth;
+
+            for (int ny = std::max(cy - 1, 0); ny <= std::min(cy + 1, gridHeight - 1); ny++) {
+                for (int nx = std::max(cx - 1, 0); nx <= std::min(cx + 1, gridWidth - 1); nx++) {
+                    int c = ny * gridWidth + nx;
+                    for (int k = cellStart[c]; k < cellStart[c + 1]; k++) {
+                        size_t j = cellParticles[k];
+                        if (j == i) continue;
+
+                        Particle &b = particles[j];
+                        sf::Vector2f sep = a.position - b.position;
+                        float minDist = a.radius + b.radius;
+                        float dist2 = sep.x * sep.x + sep.y * sep.y;
+                        if (dist2 >= minDist * minDist) continue;
+
+                        float dist = std::sqrt(dist2);
+                        sf::Vector2f normal = (dist > 1e-6f) 
+                            ? sf::Vector2f(sep.x / dist, sep.y / dist)
+                            : coincidentDirection(i, j);
+                        
+                        // Each grain of the pair moves half the overlap
+                        float push = 0.5f * (minDist - dist);
+                        collisionShift[i] += sf::Vector2f(normal.x * push, normal.y * push);
+                        overlapping = true;
+                    }
+                }
+            }
+        }
+
+        for (size_t i = 0; i < particles.size(); i++) {
+            Particle &particle = particles[i];
+            sf::Vector2f shift = collisionShift[i];
+            float len = std::sqrt(shift.x * shift.x + shift.y * shift.y);
+            if (len == 0) continue;
+            sf::Vector2f normal(shift.x / len, shift.y / len);
+
+            // Many contacts add up, so cap the move per pass at one radius; further passes/steps finish the job
+            float step = std::min(len, particle.radius);
+            particle.position += sf::Vector2f(normal.x * step, normal.y * step);
+
+            // Inelastic contact: drop the velocity component pointing back into the pile
+            float vn = particle.velocity.x * normal.x + particle.velocity.y * normal.y;
+            if (vn < 0) particle.velocity -= sf::Vector2f(normal.x * vn, normal.y * vn);
+        }
+        return overlapping;
     }
 
     void reset(){
@@ -109,8 +229,14 @@ public:
     void draw(sf::RenderWindow &window) {
         if (!WavePlate->simulating) return;
 
+        // Skip grains outside the view so draw cost follows what is on screen
+        sf::FloatRect bounds = viewBounds(window.getView());
+
         for (auto &particle : particles){
-            drawCircle(window, particle.position + offset, particle.radius, particle.color);
+            sf::Vector2f p = particle.position + offset;
+            if (p.x + particle.radius < bounds.left || p.x - particle.radius > bounds.left + bounds.width)  continue;
+            if (p.y + particle.radius < bounds.top  || p.y - particle.radius > bounds.top  + bounds.height) continue;
+            drawCircle(window, p, particle.radius, particle.color);
         }
     }
 };
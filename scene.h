@@ -13,10 +13,12 @@ struct Scene
 {
     std::vector<sf::Vector2f> boundary;
     std::vector<WaveSource> waveSources;
+    EdgeMode edgeMode;
 
-    Scene(std::vector<sf::Vector2f> boundaryVertices2f, std::vector<WaveSource> waveSources)
+    Scene(std::vector<sf::Vector2f> boundaryVertices2f, std::vector<WaveSource> waveSources, EdgeMode edgeMode=EDGE_REFLECTIVE)
     : boundary(boundaryVertices2f)
     , waveSources(waveSources)
+    , edgeMode(edgeMode)
     {}
 };
 
@@ -38,6 +40,28 @@ inline Scene createScene(int choice) {
         return Scene(boundaryVertices2f, waveSources);
         break;
     case 1:
+        // Open field: tight domain with absorbing edges, so waves radiate away instead of reflecting
+        boundaryVertices2f.push_back(sf::Vector2f(-100, 100));
+        boundaryVertices2f.push_back(sf::Vector2f(100, 100));
+        boundaryVertices2f.push_back(sf::Vector2f(100, -100));
+        boundaryVertices2f.push_back(sf::Vector2f(-100, -100));
+        boundaryVertices2f.push_back(sf::Vector2f(-100, 100));
+
+        waveSources.push_back(WaveSource(sf::Vector2f(0, 0), 0.2, 0));
+        return Scene(boundaryVertices2f, waveSources, EDGE_ABSORBING);
+        break;
+    case 2:
+        // Large Chladni plate, bigger than the window; zoom out to view it through the display pyramid
+        boundaryVertices2f.push_back(sf::Vector2f(-800, 800));
+        boundaryVertices2f.push_back(sf::Vector2f(800, 800));
+        boundaryVertices2f.push_back(sf::Vector2f(800, -800));
+        boundaryVertices2f.push_back(sf::Vector2f(-800, -800));
+        boundaryVertices2f.push_back(sf::Vector2f(-800, 800));
+
+        waveSources.push_back(WaveSource(sf::Vector2f(0, 0), 0.2, 0));
+        return Scene(boundaryVertices2f, waveSources);
+        break;
+    case 3:
         // May add more in the future
         break;
     default:
@@ -6,6 +6,7 @@ Utility functions
 #define UTILS_H
 
 #include <SFML/Graphics.hpp>
+#include <cmath>
 #include <random>
 
 
@@ -80,6 +81,15 @@ inline void drawBoundary(sf::RenderWindow &window, std::vector<sf::Vector2f> &bo
 }
 
 
+inline sf::FloatRect viewBounds(const sf::View &view){
+    // World-space rectangle covered by a view; sizes are made positive since the y axis is flipped
+    sf::Vector2f center = view.getCenter();
+    sf::Vector2f size = view.getSize();
+    float w = std::abs(size.x), h = std::abs(size.y);
+    return sf::FloatRect(center.x - w / 2, center.y - h / 2, w, h);
+}
+
+
 inline void print(int value) {
     std::cout << value << std::endl;
 }
@@ -6,7 +6,9 @@ Wave plates & wave sources
 #define WAVE_H
 
 #include <SFML/Graphics.hpp>
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <vector>
 
 #include "utils.h"
@@ -32,6 +34,13 @@ public:
 };
 
 
+enum EdgeMode {
+    EDGE_REFLECTIVE,      // Every plate edge reflects (default)
+    EDGE_ABSORBING,       // Damping layer inside the drawn boundary, for open-field scenes
+    EDGE_ABSORBING_BOX    // Damping layer along the bounding box only; other drawn edges still reflect
+};
+
+
 class Wave
 {
 
@@ -41,6 +50,12 @@ public:
     std::vector<WaveSource> wavePoints;
     double dt0, alpha;
 
+    // Absorbing edges: velocity is damped by exp(-sigma dt), sigma ramping up quadratically towards the edge
+    EdgeMode edgeMode = EDGE_REFLECTIVE;
+    int absorbingWidth = 24;         // Layer thickness in cells
+    double absorbingStrength = 2.0;  // sigma at the edge
+    std::vector<float> damping;  // sigma per cell (row-major), empty in EDGE_REFLECTIVE mode
+
     // Program variables
     std::vector<sf::Vector2f> boundaryVertices2f;
     std::vector<std::vector<bool>> platePixels;
@@ -49,13 +64,17 @@ public:
     bool simulating = false;
     int height, width;
 
-    sf::Vector2f displayPosition;
-    sf::Vector2f displaySize;
+    // Display pyramid: level l halves level l-1, keeping the min & max of each 2x2 block so
+    // nodal lines (sign changes) and antinodes survive downsampling. Level 0 is read straight from u_1.
+    std::vector<std::vector<float>> lodMin, lodMax;
+    std::vector<std::vector<bool>> lodMask;
+    std::vector<int> lodWidth, lodHeight;
+    std::vector<uint8_t> displayPixels;
+    sf::Texture displayTexture;
+    sf::Vector2u displayTextureSize;
 
-    Wave(double alpha, sf::Vector2f displayPosition, sf::Vector2f displaySize) 
+    Wave(double alpha) 
         : alpha(alpha)
-        , displayPosition(displayPosition)
-        , displaySize(displaySize) 
     {};
 
     void setWaveSource(WaveSource waveSource){
@@ -68,11 +87,13 @@ public:
 
 
     void begin(double dt){
-        // Create Plate Pixels
-        int minX = displayPosition.x + displaySize.x;
-        int maxX = displayPosition.x;
-        int minY = displayPosition.y;
-        int maxY = displayPosition.y - displaySize.y;
+        if (boundaryVertices2f.empty()) return;  // e.g. an unused scene slot; stays not simulating
+
+        // Create Plate Pixels from the bounding box of the boundary itself
+        int minX = boundaryVertices2f.front().x;
+        int maxX = boundaryVertices2f.front().x;
+        int minY = boundaryVertices2f.front().y;
+        int maxY = boundaryVertices2f.front().y;
 
         for (auto &v : boundaryVertices2f) {
             minX = (v.x < minX) ? v.x : minX;
@@ -99,6 +120,9 @@ public:
             }
         } 
 
+        allocatePyramid();
+        computeDamping();
+
         boundaryIsDefined = true;
         dt0 = std::min(dt, 1.0f / alpha);
         simulating = true;
@@ -113,6 +137,7 @@ public:
 
         dt1 = std::min(dt1, 1.0 / alpha);
         updateWavePoints(u_2, t);
+        bool absorbing = !damping.empty();
 
         for (int y = 0; y < height; y++){
             for (int x = 0; x < width; x++){
@@ -127,7 +152,12 @@ public:
 
                 double stencil = -4 * mid + up + right + down + left;
                 double du_dt0 = (u_1[y][x] - u_0[y][x]) / dt0;
-                u_2[y][x] = dt1 * (alpha * stencil + du_dt0) + u_1[y][x];
+                double du_dt1 = alpha * stencil + du_dt0;
+                if (absorbing){
+                    float sigma = damping[static_cast<size_t>(y) * width + x];
+                    if (sigma > 0) du_dt1 *= std::exp(-sigma * dt1);
+                }
+                u_2[y][x] = dt1 * du_dt1 + u_1[y][x];
 
                 // u_2[y][x] = 2 * u_1[y][x] - u_0[y][x] + alpha * alpha * 0.01 * 0.01 * stencil;
             }
@@ -144,6 +174,12 @@ public:
         u_0.clear();
         u_1.clear();
         u_2.clear();
+        damping.clear();
+        lodMin.clear();
+        lodMax.clear();
+        lodMask.clear();
+        lodWidth.clear();
+        lodHeight.clear();
 
         boundaryIsDefined = false;
         simulating = false;
@@ -152,23 +188,199 @@ public:
 
 
     void draw(sf::RenderWindow &window){
+        // Uploads only the part of the plate inside the view, at the coarsest level that still
+        // gives at least one texel per screen pixel, so the upload is bounded by the window size
         if (!simulating) return;
         if (width == 0 || height == 0) return;
+        if (window.getSize().x == 0 || window.getSize().y == 0) return;  // Minimized
+
+        sf::FloatRect bounds = viewBounds(window.getView());
+        int x0 = std::max(0,      static_cast<int>(std::floor(bounds.left - offset.x)));
+        int y0 = std::max(0,      static_cast<int>(std::floor(bounds.top  - offset.y)));
+        int x1 = std::min(width,  static_cast<int>(std::ceil(bounds.left + bounds.width  - offset.x)));
+        int y1 = std::min(height, static_cast<int>(std::ceil(bounds.top  + bounds.height - offset.y)));
+        if (x0 >= x1 || y0 >= y1) return;
+
+        double cellsPerPixel = bounds.width / window.getSize().x;
+        int level = (cellsPerPixel > 1) ? static_cast<int>(std::floor(std::log2(cellsPerPixel))) : 0;
+        level = std::min(level, static_cast<int>(lodWidth.size()) - 1);
+
+        // Align to whole blocks of the chosen level so every coarse texel is built from fresh children
+        int block = 1 << level;
+        x0 -= x0 % block;
+        y0 -= y0 % block;
+        x1 = std::min(width,  (x1 + block - 1) / block * block);
+        y1 = std::min(height, (y1 + block - 1) / block * block);
+
+        buildPyramid(level, x0, y0, x1, y1);
+
+        // Visible region in level coordinates
+        int lx0 = x0 >> level, ly0 = y0 >> level;
+        int lx1 = std::min(lodWidth[level],  (x1 + block - 1) >> level);
+        int ly1 = std::min(lodHeight[level], (y1 + block - 1) >> level);
+        int w = lx1 - lx0, h = ly1 - ly0;
+
+        displayPixels.resize(static_cast<size_t>(w) * h * 4);
+        for (int y = 0; y < h; y++){
+            for (int x = 0; x < w; x++){
+                uint8_t *pixel = &displayPixels[(static_cast<size_t>(y) * w + x) * 4];
+                double n;
+                if (!samplePyramid(level, lx0 + x, ly0 + y, n)){
+                    pixel[0] = pixel[1] = pixel[2] = pixel[3] = 0;
+                    continue;
+                }
+                sf::Color color = toGreyscale(n);
+                pixel[0] = color.r; pixel[1] = color.g; pixel[2] = color.b; pixel[3] = color.a;
+            }
+        }
+
+        // Texture only grows, so steady-state frames just update a sub-rectangle
+        if (displayTextureSize.x < static_cast<unsigned>(w) || displayTextureSize.y < static_cast<unsigned>(h)){
+            displayTextureSize = sf::Vector2u(std::max<unsigned>(displayTextureSize.x, w), std::max<unsigned>(displayTextureSize.y, h));
+            displayTexture.create(displayTextureSize.x, displayTextureSize.y);
+        }
+        displayTexture.update(displayPixels.data(), w, h, 0, 0);
+
+        sf::Sprite sprite(displayTexture, sf::IntRect(0, 0, w, h));
+        sprite.setPosition(offset + sf::Vector2f(lx0 << level, ly0 << level));
+        sprite.setScale(block, block);
+        window.draw(sprite);
+    }
+
 
-        sf::Image platePixelsImage;
-        platePixelsImage.create(width, height, sf::Color::Transparent);
+    void setEdgeMode(EdgeMode mode){
+        edgeMode = mode;
+        if (boundaryIsDefined) computeDamping();
+    }
+
+    void computeDamping(){
+        damping.clear();
+        if (edgeMode == EDGE_REFLECTIVE) return;
+        damping.assign(static_cast<size_t>(width) * height, 0);
+
+        // Distance (in cells) of each plate cell from the absorbing edge
+        std::vector<std::vector<int>> distance(height, std::vector<int>(width, absorbingWidth));
+
+        if (edgeMode == EDGE_ABSORBING_BOX){
+            for (int y = 0; y < height; y++){
+                for (int x = 0; x < width; x++){
+                    int d = std::min(std::min(x, width - 1 - x), std::min(y, height - 1 - y));
+                    distance[y][x] = std::min(d, absorbingWidth);
+                }
+            }
+        }
+        else {
+            // Multi-source BFS from every plate cell that touches a non-plate cell
+            std::vector<std::pair<int, int>> frontier, next;
+            for (int y = 0; y < height; y++){
+                for (int x = 0; x < width; x++){
+                    if (!platePixels[y][x]) continue;
+                    if (!isOnGrid(x, y+1) || !isOnGrid(x+1, y) || !isOnGrid(x, y-1) || !isOnGrid(x-1, y)){
+                        distance[y][x] = 0;
+                        frontier.push_back({x, y});
+                    }
+                }
+            }
+
+            const int dx[4] = {0, 1, 0, -1};
+            const int dy[4] = {1, 0, -1, 0};
+            for (int d = 1; d < absorbingWidth && !frontier.empty(); d++){
+                next.clear();
+                for (auto &cell : frontier){
+                    for (int k = 0; k < 4; k++){
+                        int x = cell.first + dx[k], y = cell.second + dy[k];
+                        if (!isOnGrid(x, y) || distance[y][x] <= d) continue;
+                        distance[y][x] = d;
+                        next.push_back({x, y});
+                    }
+                }
+                std::swap(frontier, next);
+            }
+        }
 
         for (int y = 0; y < height; y++){
             for (int x = 0; x < width; x++){
-                if (platePixels[y][x]){  // OPTIMIZE THIS
-                    platePixelsImage.setPixel(x, y, toGreyscale(u_1[y][x]));
-                }
+                if (!platePixels[y][x] || distance[y][x] >= absorbingWidth) continue;
+                double depth = 1.0 - static_cast<double>(distance[y][x]) / absorbingWidth;
+                damping[static_cast<size_t>(y) * width + x] = absorbingStrength * depth * depth;
             }
         }
+    }
 
-        sf::Texture texture; texture.loadFromImage(platePixelsImage);
-        sf::Sprite sprite(texture); sprite.setPosition(offset);
-        window.draw(sprite);
+
+    void allocatePyramid(){
+        lodMin = {{}};
+        lodMax = {{}};
+        lodMask = {{}};
+        lodWidth = {width};
+        lodHeight = {height};
+
+        while (lodWidth.back() > 1 || lodHeight.back() > 1){
+            int w = (lodWidth.back() + 1) / 2;
+            int h = (lodHeight.back() + 1) / 2;
+            lodWidth.push_back(w);
+            lodHeight.push_back(h);
+            lodMin.push_back(std::vector<float>(static_cast<size_t>(w) * h, 0));
+            lodMax.push_back(std::vector<float>(static_cast<size_t>(w) * h, 0));
+            lodMask.push_back(std::vector<bool>(static_cast<size_t>(w) * h, false));
+        }
+    }
+
+    bool samplePyramid(int level, int x, int y, double &n){
+        // A block that changes sign (or touches zero) contains a node and is drawn grey so nodal
+        // lines survive; otherwise the extreme with the larger magnitude is shown
+        if (level == 0){
+            n = u_1[y][x];
+            return platePixels[y][x];
+        }
+        size_t i = static_cast<size_t>(y) * lodWidth[level] + x;
+        float lo = lodMin[level][i], hi = lodMax[level][i];
+        if (lo <= 0 && hi >= 0) n = 0;
+        else n = (std::abs(hi) >= std::abs(lo)) ? hi : lo;
+        return lodMask[level][i];
+    }
+
+    void buildPyramid(int maxLevel, int x0, int y0, int x1, int y1){
+        // Rebuilds levels 1..maxLevel over the grid rectangle [x0, x1) x [y0, y1) only
+        for (int level = 1; level <= maxLevel; level++){
+            int lx0 = x0 >> level, ly0 = y0 >> level;
+            int lx1 = std::min(lodWidth[level],  (x1 + (1 << level) - 1) >> level);
+            int ly1 = std::min(lodHeight[level], (y1 + (1 << level) - 1) >> level);
+
+            for (int y = ly0; y < ly1; y++){
+                for (int x = lx0; x < lx1; x++){
+                    float lo = 0, hi = 0;
+                    bool any = false;
+
+                    for (int dy = 0; dy < 2; dy++){
+                        for (int dx = 0; dx < 2; dx++){
+                            int cx = 2 * x + dx, cy = 2 * y + dy;
+                            if (cx >= lodWidth[level - 1] || cy >= lodHeight[level - 1]) continue;
+
+                            float childLo, childHi;
+                            if (level == 1){
+                                if (!platePixels[cy][cx]) continue;
+                                childLo = childHi = u_1[cy][cx];
+                            } else {
+                                size_t c = static_cast<size_t>(cy) * lodWidth[level - 1] + cx;
+                                if (!lodMask[level - 1][c]) continue;
+                                childLo = lodMin[level - 1][c];
+                                childHi = lodMax[level - 1][c];
+                            }
+
+                            lo = any ? std::min(lo, childLo) : childLo;
+                            hi = any ? std::max(hi, childHi) : childHi;
+                            any = true;
+                        }
+                    }
+
+                    size_t i = static_cast<size_t>(y) * lodWidth[level] + x;
+                    lodMin[level][i] = lo;
+                    lodMax[level][i] = hi;
+                    lodMask[level][i] = any;
+                }
+            }
+        }
     }
 
 